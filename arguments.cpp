@@ -0,0 +1,14 @@
+// The conversion machinery for the arguments module. arguments.cppm leaves detail/convert.hpp out of its interface and
+// only declares transcode with extern template; the instantiations live here. Everything the module declares is
+// attached to the global module, so this is an ordinary translation unit using the header. It also emits the
+// .init_array entry that records argc and argv, which the module interface cannot export.
+
+#include <arguments.hpp>
+
+namespace std::arg_detail {
+  template void transcode(const argument::value_type*, void*, char* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  template void transcode(const argument::value_type*, void*, wchar_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  template void transcode(const argument::value_type*, void*, char8_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  template void transcode(const argument::value_type*, void*, char16_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  template void transcode(const argument::value_type*, void*, char32_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+}
@@ -0,0 +1,50 @@
+// Module interface for std::arguments and std::multicall_dispatcher, `import arguments;` in place of `#include <arguments.hpp>`.
+// Experimental, see README.md.
+//
+// The declarations come from the headers themselves, included in the module purview with ARGUMENTS_MODULE defined.
+// They are exported inside extern "C++", which keeps them attached to the global module: a translation unit may import
+// the module and also include the headers (directly or through another header), and the two sets of declarations are
+// the same entities. For that they must not differ between the two modes, ARGUMENTS_MODULE only leaves out
+// detail/convert.hpp.
+//
+// Every standard header the headers (transitively) use has to be included in the global module fragment first, their
+// own includes of them then do nothing. <codecvt> is deliberately absent: argument::string<EcharT>() calls transcode,
+// which is instantiated in arguments.cpp.
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iosfwd>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifdef ARGUMENTS_INSTRUMENTATION
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+export module arguments;
+
+#define ARGUMENTS_MODULE
+export extern "C++" {
+#include <arguments.hpp>
+#include <multicall.hpp>
+}
@@ -1,18 +1,22 @@
 #ifndef ARGUMENTS_HPP
 #define ARGUMENTS_HPP
 
-#include <codecvt>
 #include <compare>
 #include <cstddef>
 #include <format>
+#include <iosfwd>
 #include <iterator>
-#include <ostream>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
-#include <detail/locale_conv.hpp>
+#include <detail/instrumentation.hpp>
+#ifndef ARGUMENTS_MODULE
+#include <detail/convert.hpp>
+#endif
 #include <detail/windows_parse.hpp>
 
 #ifdef _WIN32
@@ -27,46 +31,68 @@ namespace std {
 
 namespace std::arg_detail {
   #ifndef _WIN32
-  int __argc;
-  char** __argv;
+  // Inline so every translation unit shares one definition, whether it includes this header or imports the module.
+  inline int __argc = 0;
+  inline char** __argv = nullptr;
+  #ifdef __ELF__
+  // Registered through an .init_array entry in a COMDAT group rather than __attribute__((constructor)), which would
+  // add an entry per translation unit. The linker keeps one copy of the group, so the hook runs once however many
+  // translation units include this header. .init_array.00000 is where constructor(0) would put it; glibc passes the
+  // init_array functions argc, argv and envp.
+  [[gnu::used]] inline void __init_argv_argc(int argc, char** argv) asm("__arguments_init_argv_argc");
+  inline void __init_argv_argc(int argc, char** argv) {
+    __argc = argc;
+    __argv = argv;
+  }
+  #ifndef ARGUMENTS_MODULE // an asm declaration cannot be exported, arguments.cpp emits it for the module
+  // .ifndef because LTO concatenates the top-level asm of many translation units into one object
+  asm(
+    ".ifndef __arguments_init_argv_argc_entry\n"
+    ".pushsection .init_array.00000, \"awG\", %init_array, __arguments_init_argv_argc_entry, comdat\n"
+    #if __SIZEOF_POINTER__ == 8
+    ".p2align 3\n"
+    #else
+    ".p2align 2\n"
+    #endif
+    "__arguments_init_argv_argc_entry:\n"
+    ".dc.a __arguments_init_argv_argc\n"
+    ".popsection\n"
+    ".endif"
+  );
+  #endif
+  #else
+  // Each translation unit may register the constructor, which is harmless since every call stores the same values.
   #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wprio-ctor-dtor"
-  __attribute__((constructor(0))) void __init_argv_argc(int argc, char** argv) {
+  __attribute__((constructor(0))) inline void __init_argv_argc(int argc, char** argv) {
     __argc = argc;
     __argv = argv;
   }
   #pragma GCC diagnostic pop
+  #endif
   #else
   // #error "Windows not implemented just yet"
   #endif
 
-  template<typename _EcharT> struct Codecvt;
-  // copied from https://github.com/gcc-mirror/gcc/blob/a8b4ea1bcc10b5253992f4b932aec6862aef32fa/libstdc%2B%2B-v3/include/bits/fs_path.h#L868C1-L892C9
-  // path::_Codecvt<C> Performs conversions between C and path::string_type.
-  // The native encoding of char strings is the OS-dependent current
-  // encoding for pathnames. FIXME: We assume this is UTF-8 everywhere,
-  // but should use a Windows API to query it.
-
-  // Converts between native pathname encoding and char16_t or char32_t.
-  template<typename _EcharT>
-      struct Codecvt
-      // Need derived class here because std::codecvt has protected destructor.
-      : std::codecvt<_EcharT, char, mbstate_t>
-      { };
-
-  // Converts between native pathname encoding and native wide encoding.
-  // The native encoding for wide strings is the execution wide-character
-  // set encoding. FIXME: We assume that this is either UTF-32 or UTF-16
-  // (depending on the width of wchar_t). That matches GCC's default,
-  // but can be changed with -fwide-exec-charset.
-  // We need a custom codecvt converting the native pathname encoding
-  // to/from the native wide encoding.
-  template<>
-      struct Codecvt<wchar_t>
-      : std::conditional_t<sizeof(wchar_t) == sizeof(char32_t),
-              std::codecvt_utf8<wchar_t>,       // UTF-8 <-> UTF-32
-              std::codecvt_utf8_utf16<wchar_t>> // UTF-8 <-> UTF-16
-      { };
+  // Defined in detail/convert.hpp, which the module interface leaves out
+  template<class EcharT, class value_type>
+    void transcode(
+      const value_type* arg,
+      void* out,
+      EcharT* (*resize)(void* out, size_t size),
+      void* scratch,
+      char* (*resize_scratch)(void* scratch, size_t size)
+    );
+
+  // transcode's resize callbacks for a basic_string, out points to the string
+  template<class String>
+    typename String::value_type* resize_string(void* out, size_t size) {
+      auto& str = *static_cast<String*>(out);
+      size_t capacity = str.capacity();
+      str.resize(size);
+      instrumentation::count_allocation(capacity, str.capacity());
+      return str.data();
+    }
 }
 
 namespace std {
@@ -102,48 +128,20 @@ namespace std {
               class Allocator = allocator<EcharT>>
       basic_string<EcharT, traits, Allocator>
         string(const Allocator& a = Allocator()) const {
-          // Following what was done in libstdc++'s filesystem::path implementation
-          // https://github.com/gcc-mirror/gcc/blob/a8b4ea1bcc10b5253992f4b932aec6862aef32fa/libstdc%2B%2B-v3/include/bits/fs_path.h#L1109
-          // TODO: For now hacky and inefficient
           using String = basic_string<EcharT, traits, Allocator>;
-          if(!arg || !*arg) {
-            return String(a);
-          }
-          #ifndef _WIN32
-          string_view u8_string = arg;
-          #else
-          // First convert native string from UTF-16 to to UTF-8.
-          // XXX This assumes that the execution wide-character set is UTF-16.
-          std::codecvt_utf8_utf16<value_type> u8cvt;
-
-          using alloc_traits = std::allocator_traits<Allocator>;
-          using char_alloc = alloc_traits::template rebind_alloc<char>;
+          using char_alloc = typename allocator_traits<Allocator>::template rebind_alloc<char>;
           using U8String = basic_string<char, char_traits<char>, char_alloc>;
+          String str(a);
+          // UTF-8 intermediate for conversions from UTF-16 (Windows), stays empty otherwise
           U8String u8_string{char_alloc{a}};
-          const value_type* __wfirst = arg;
-          const value_type* __wlast = __wfirst + std::char_traits<value_type>::length(arg);
-          if(!__str_codecvt_out_all(__wfirst, __wlast, u8_string, u8cvt)) {
-            throw std::runtime_error("Conversion failed for argument");
-          }
-          if constexpr (is_same_v<EcharT, char>) {
-            return u8_string; // XXX assumes native ordinary encoding is UTF-8.
-          }
-          #endif
-          const char* first = u8_string.data();
-          const char* last = first + u8_string.size();
-
-          // Convert UTF-8 string to requested format.
-          if constexpr(is_same_v<EcharT, char8_t>) {
-            return String(first, last, a);
-          } else {
-            // Convert UTF-8 to wide string.
-            String wstr(a);
-            arg_detail::Codecvt<EcharT> target_cvt;
-            if (__str_codecvt_in_all(first, last, wstr, target_cvt)) {
-              return wstr;
-            }
-          }
-          throw std::runtime_error("Conversion failed for argument");
+          arg_detail::transcode<EcharT>(
+            arg,
+            &str,
+            arg_detail::resize_string<String>,
+            &u8_string,
+            arg_detail::resize_string<U8String>
+          );
+          return str;
         }
     std::string    string() const {
       return string<char>();
@@ -178,7 +176,20 @@ namespace std {
     argument() {}
     template<class Allocator> friend class arguments;
   };
+}
 
+#ifdef ARGUMENTS_MODULE
+// instantiated in arguments.cpp
+namespace std::arg_detail {
+  extern template void transcode(const argument::value_type*, void*, char* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  extern template void transcode(const argument::value_type*, void*, wchar_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  extern template void transcode(const argument::value_type*, void*, char8_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  extern template void transcode(const argument::value_type*, void*, char16_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+  extern template void transcode(const argument::value_type*, void*, char32_t* (*)(void*, size_t), void*, char* (*)(void*, size_t));
+}
+#endif
+
+namespace std {
   // [arguments.argument.fmt], formatter
   template<typename charT> struct formatter<argument, charT> : formatter<argument::string_view_type, charT> {
     template<class FormatContext>
@@ -192,6 +203,8 @@ namespace std {
 namespace std {
   class arguments_iterator {
   public:
+    using iterator_concept = contiguous_iterator_tag;
+    using iterator_category = random_access_iterator_tag;
     using value_type = const argument;
     using size_type = size_t;
     using difference_type = ptrdiff_t;
@@ -229,29 +242,29 @@ namespace std {
       return copy;
     }
 
-    friend arguments_iterator operator+(arguments_iterator it, size_type i) {
+    friend arguments_iterator operator+(arguments_iterator it, difference_type i) {
       return {it.arg + i};
     }
-    friend arguments_iterator operator+(size_type i, arguments_iterator it) {
+    friend arguments_iterator operator+(difference_type i, arguments_iterator it) {
       return {it.arg + i};
     }
-    friend arguments_iterator operator-(arguments_iterator it, size_type i) {
+    friend arguments_iterator operator-(arguments_iterator it, difference_type i) {
       return {it.arg - i};
     }
     friend difference_type operator-(arguments_iterator a, arguments_iterator b) {
       return a.arg - b.arg;
     }
 
-    arguments_iterator& operator+=(size_type i) {
+    arguments_iterator& operator+=(difference_type i) {
       arg += i;
       return *this;
     }
-    arguments_iterator& operator-=(size_type i) {
+    arguments_iterator& operator-=(difference_type i) {
       arg -= i;
       return *this;
     }
 
-    reference operator[](size_type i) const {
+    reference operator[](difference_type i) const {
       return arg[i];
     }
 
@@ -271,6 +284,8 @@ namespace std {
     template<class Allocator> friend class arguments;
   };
 
+  static_assert(contiguous_iterator<arguments_iterator>);
+
   template<class Allocator/* = allocator<argument>*/>
   class arguments {
   public:
@@ -289,19 +304,38 @@ namespace std {
     // [arguments.view.cons], constructors
     arguments() noexcept(noexcept(Allocator())) : arguments(Allocator()) {}
     arguments(const Allocator&) {
+      arg_detail::instrumentation::add(arg_detail::instrumentation::constructions);
       #ifndef _WIN32
       args.reserve(arg_detail::__argc);
       for(const auto& arg : std::span{arg_detail::__argv, arg_detail::__argv + arg_detail::__argc}) {
         args.push_back(argument(arg));
       }
       #else
-      parsed_args = arg_detail::parse_command_line(GetCommandLineW());
-      for(const auto& arg : parsed_args) {
-        args.push_back(argument(arg.c_str()));
+      {
+        arg_detail::instrumentation::scoped_timer timer(arg_detail::instrumentation::parse_nanoseconds);
+        parsed_args = arg_detail::parse_command_line(GetCommandLineW());
       }
+      index_parsed_args();
       #endif
     }
 
+    #ifdef _WIN32
+    // args and parsed_argv point into this object's parsed_args, a copy has to point into its own. Moving keeps the
+    // strings' addresses since the vector's buffer is transferred.
+    arguments(const arguments& other) : parsed_args(other.parsed_args) {
+      index_parsed_args();
+    }
+    arguments(arguments&&) noexcept = default;
+    arguments& operator=(const arguments& other) {
+      if(this != &other) {
+        parsed_args = other.parsed_args;
+        index_parsed_args();
+      }
+      return *this;
+    }
+    arguments& operator=(arguments&&) noexcept = default;
+    #endif
+
     // [arguments.view.access], access
     reference operator[](size_type index) const noexcept {
       return {args[index]};
@@ -320,6 +354,18 @@ namespace std {
     bool empty() const noexcept {
       return args.empty();
     }
+    const_pointer data() const noexcept {
+      return args.data();
+    }
+    // NUL-terminated argument vector for C APIs (getopt, execv, ...), not a copy. On POSIX this is the argv passed to
+    // the program, so an API that permutes it (e.g. GNU getopt) will not be reflected in this arguments object.
+    const argument::value_type* const* argv() const noexcept {
+      #ifndef _WIN32
+      return arg_detail::__argv;
+      #else
+      return parsed_argv.data();
+      #endif
+    }
 
     // [arguments.view.iterators], iterators
     const_iterator begin() const noexcept {
@@ -353,6 +399,19 @@ namespace std {
   private:
     #ifdef _WIN32
     std::vector<std::wstring> parsed_args; // just easy for a simple implementation
+    std::vector<const wchar_t*> parsed_argv; // backs argv()
+
+    void index_parsed_args() {
+      args.clear();
+      parsed_argv.clear();
+      args.reserve(parsed_args.size());
+      parsed_argv.reserve(parsed_args.size() + 1);
+      for(const auto& arg : parsed_args) {
+        args.push_back(argument(arg.c_str()));
+        parsed_argv.push_back(arg.c_str());
+      }
+      parsed_argv.push_back(nullptr);
+    }
     #endif
     std::vector<argument> args; // just easy for a simple implementation
   };
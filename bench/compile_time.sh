@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# Compares build time of N translation units including arguments.hpp against N translation units importing the
+# arguments module. Usage: bench/compile_time.sh [number of translation units]
+set -euo pipefail
+
+tus=${1:-200}
+root=$(cd "$(dirname "$0")/.." && pwd)
+build="$root/build-compile-bench"
+
+cmake -S "$root" -B "$build" -G Ninja -DCMAKE_BUILD_TYPE=Release \
+  -DARGUMENTS_BUILD_MODULE=On -DARGUMENTS_BUILD_BENCHMARKS=On -DARGUMENTS_COMPILE_BENCHMARK_TUS="$tus" > /dev/null
+
+time_target() {
+  local start end
+  start=$(date +%s.%N)
+  cmake --build "$build" --target "$1" > /dev/null
+  end=$(date +%s.%N)
+  echo "$1: $(echo "$end - $start" | bc) s"
+}
+
+cmake --build "$build" --target clean > /dev/null
+time_target compile_bench_header
+time_target arguments_module
+time_target compile_bench_module
@@ -0,0 +1,45 @@
+// Measures what enabling the instrumentation costs: built twice, as bench_instrumentation_off and
+// bench_instrumentation_on (with ARGUMENTS_INSTRUMENTATION defined). That the "off" build carries no instrumentation
+// at all is checked separately on the generated code by bench/instrumentation_codegen.sh.
+
+#include <arguments.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+template<typename F>
+double nanoseconds_per_iteration(std::size_t iterations, F f) {
+  auto start = std::chrono::steady_clock::now();
+  for(std::size_t i = 0; i < iterations; i++) {
+    f();
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char** argv) {
+  std::size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  std::size_t sink = 0;
+
+  double construct = nanoseconds_per_iteration(iterations, [&] {
+    std::arguments args;
+    sink += args.size();
+  });
+
+  std::arguments args;
+  double convert = nanoseconds_per_iteration(iterations, [&] {
+    for(const auto& arg : args) {
+      sink += arg.string().size();
+      sink += arg.u8string().size();
+      sink += arg.u32string().size();
+    }
+  });
+
+  std::printf("instrumentation: %s\n", std::arguments_statistics::enabled ? "on" : "off");
+  std::printf("construct:        %10.2f ns/iter\n", construct);
+  std::printf("convert all args: %10.2f ns/iter\n", convert);
+  std::printf("(sink %zu)\n", sink);
+  std::cout << std::arguments_statistics::snapshot();
+}
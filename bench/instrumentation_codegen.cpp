@@ -0,0 +1,15 @@
+// Exercises every instrumented path without touching the statistics API, see bench/instrumentation_codegen.sh.
+
+#include <arguments.hpp>
+
+#include <cstddef>
+
+std::size_t probe() {
+  std::arguments args;
+  std::size_t size = 0;
+  for(const auto& arg : args) {
+    size += arg.string().size() + arg.wstring().size() + arg.u8string().size();
+    size += arg.u16string().size() + arg.u32string().size();
+  }
+  return size;
+}
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+# Checks that the disabled instrumentation layer leaves nothing in optimized code: bench/instrumentation_codegen.cpp
+# compiled without ARGUMENTS_INSTRUMENTATION must reference no instrumentation symbol and use no thread-local storage.
+# The instrumented build is checked the other way round to show the check can fail.
+# Usage: bench/instrumentation_codegen.sh [compiler flags...]
+set -euo pipefail
+shopt -s inherit_errexit # a failed compile inside $(hooks ...) must stop the script, not count as 0
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+cxx=${CXX:-c++}
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+hooks() {
+  local object="$work/$1.o"
+  shift
+  "$cxx" -std=c++23 -O2 -I"$root" "$@" -c "$root/bench/instrumentation_codegen.cpp" -o "$object"
+  local symbols tls
+  symbols=$(nm -C "$object" | grep -c "arg_detail::instrumentation" || true)
+  tls=$(readelf -S -W "$object" | grep -c "\.tbss\|\.tdata" || true)
+  echo "$((symbols + tls))"
+}
+
+off=$(hooks off "$@")
+on=$(hooks on -DARGUMENTS_INSTRUMENTATION "$@")
+echo "instrumentation references: off $off, on $on"
+if [ "$on" -eq 0 ]; then
+  echo "check is not detecting instrumentation" >&2
+  exit 1
+fi
+if [ "$off" -ne 0 ]; then
+  echo "disabled instrumentation left code behind" >&2
+  exit 1
+fi
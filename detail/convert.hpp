@@ -0,0 +1,131 @@
+#ifndef CONVERT_HPP
+#define CONVERT_HPP
+
+#include <algorithm>
+#include <codecvt>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <detail/instrumentation.hpp>
+
+// Conversion from the native argument encoding to the encoding requested by argument::string<EcharT>(). This is the
+// heavy part of the implementation (<codecvt>) and is kept out of the module interface; with the module build it is
+// only compiled in arguments.cpp, which explicitly instantiates transcode for every character type.
+
+namespace std::arg_detail {
+  template<typename _EcharT> struct Codecvt;
+  // copied from https://github.com/gcc-mirror/gcc/blob/a8b4ea1bcc10b5253992f4b932aec6862aef32fa/libstdc%2B%2B-v3/include/bits/fs_path.h#L868C1-L892C9
+  // path::_Codecvt<C> Performs conversions between C and path::string_type.
+  // The native encoding of char strings is the OS-dependent current
+  // encoding for pathnames. FIXME: We assume this is UTF-8 everywhere,
+  // but should use a Windows API to query it.
+
+  // Converts between native pathname encoding and char16_t or char32_t.
+  template<typename _EcharT>
+      struct Codecvt
+      // Need derived class here because std::codecvt has protected destructor.
+      : std::codecvt<_EcharT, char, mbstate_t>
+      { };
+
+  // Converts between native pathname encoding and native wide encoding.
+  // The native encoding for wide strings is the execution wide-character
+  // set encoding. FIXME: We assume that this is either UTF-32 or UTF-16
+  // (depending on the width of wchar_t). That matches GCC's default,
+  // but can be changed with -fwide-exec-charset.
+  // We need a custom codecvt converting the native pathname encoding
+  // to/from the native wide encoding.
+  template<>
+      struct Codecvt<wchar_t>
+      : std::conditional_t<sizeof(wchar_t) == sizeof(char32_t),
+              std::codecvt_utf8<wchar_t>,       // UTF-8 <-> UTF-32
+              std::codecvt_utf8_utf16<wchar_t>> // UTF-8 <-> UTF-16
+      { };
+
+  // Converts arg into the caller's string through resize, which sizes that string and returns its buffer. A UTF-8
+  // intermediate, when one is needed, goes into the caller's scratch string through resize_scratch, so it is allocated
+  // with the caller's allocator. Each step writes straight into a buffer sized for its worst case, so every string
+  // involved allocates at most once and the instrumentation can count allocations exactly from capacity changes.
+  template<class EcharT, class value_type>
+    void transcode(
+      const value_type* arg,
+      void* out,
+      EcharT* (*resize)(void* out, size_t size),
+      [[maybe_unused]] void* scratch,
+      [[maybe_unused]] char* (*resize_scratch)(void* scratch, size_t size)
+    ) {
+      // Following what was done in libstdc++'s filesystem::path implementation
+      // https://github.com/gcc-mirror/gcc/blob/a8b4ea1bcc10b5253992f4b932aec6862aef32fa/libstdc%2B%2B-v3/include/bits/fs_path.h#L1109
+      instrumentation::count_conversion<EcharT>();
+      if(!arg || !*arg) {
+        return;
+      }
+      #ifndef _WIN32
+      string_view u8_string = arg;
+      #else
+      // First convert native string from UTF-16 to to UTF-8.
+      // XXX This assumes that the execution wide-character set is UTF-16.
+      const value_type* wfirst = arg;
+      const value_type* wlast = wfirst + std::char_traits<value_type>::length(arg);
+      const size_t native_bytes = (wlast - wfirst) * sizeof(value_type);
+      // a UTF-16 code unit never needs more than three UTF-8 code units
+      const size_t u8_max = (wlast - wfirst) * 3;
+      auto to_u8 = [&](char* first) {
+        std::codecvt_utf8_utf16<value_type> u8cvt;
+        mbstate_t state{};
+        const value_type* wnext;
+        char* next;
+        auto result = u8cvt.out(state, wfirst, wlast, wnext, first, first + u8_max, next);
+        if(result != codecvt_base::ok || wnext != wlast) {
+          instrumentation::add(instrumentation::conversion_failures);
+          throw std::runtime_error("Conversion failed for argument");
+        }
+        return next;
+      };
+      if constexpr(is_same_v<EcharT, char> || is_same_v<EcharT, char8_t>) {
+        // Convert straight into the result. XXX assumes native ordinary encoding is UTF-8.
+        EcharT* buffer = resize(out, u8_max);
+        char* first;
+        if constexpr(is_same_v<EcharT, char>) {
+          first = buffer;
+        } else {
+          first = reinterpret_cast<char*>(buffer);
+        }
+        resize(out, to_u8(first) - first);
+        instrumentation::add(instrumentation::bytes_transcoded, native_bytes);
+        return;
+      }
+      char* u8_first = resize_scratch(scratch, u8_max);
+      string_view u8_string(u8_first, to_u8(u8_first) - u8_first);
+      #endif
+      const char* first = u8_string.data();
+      const char* last = first + u8_string.size();
+
+      // A UTF-8 sequence never produces more code units than it has bytes
+      EcharT* buffer = resize(out, last - first);
+      if constexpr(is_same_v<EcharT, char8_t> || is_same_v<EcharT, char>) {
+        // Already UTF-8, a plain copy. XXX assumes native ordinary encoding is UTF-8.
+        std::copy(first, last, buffer);
+      } else {
+        // Convert UTF-8 to wide string.
+        Codecvt<EcharT> target_cvt;
+        mbstate_t state{};
+        const char* next;
+        EcharT* end;
+        auto result = target_cvt.in(state, first, last, next, buffer, buffer + (last - first), end);
+        if(result != codecvt_base::ok || next != last) {
+          instrumentation::add(instrumentation::conversion_failures);
+          throw std::runtime_error("Conversion failed for argument");
+        }
+        resize(out, end - buffer);
+        #ifndef _WIN32
+        instrumentation::add(instrumentation::bytes_transcoded, last - first);
+        #else
+        instrumentation::add(instrumentation::bytes_transcoded, native_bytes);
+        #endif
+      }
+    }
+}
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+
+#ifdef ARGUMENTS_INSTRUMENTATION
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+// Opt-in instrumentation for argument handling, enabled by defining ARGUMENTS_INSTRUMENTATION for the whole program
+// (cmake -DARGUMENTS_INSTRUMENTATION=On). When it is not defined every hook below is an empty inline function and the
+// snapshot API reports zeros, so instrumented code compiles either way.
+//
+// The macro changes the bodies of inline functions and templates shared by every translation unit, so it must not
+// differ between them: that would be an ODR violation, with the linker silently keeping one of the two versions.
+// Instead each translation unit leaves a marker the linker checks, see below.
+//
+// Each thread counts into its own block of relaxed atomics that only it writes, so the hot path never takes a lock.
+// A lock is only taken the first time a thread records something, when the thread exits (its counts are folded into
+// a retired total) and when a snapshot is collected.
+
+namespace std::arg_detail::instrumentation {
+  #ifdef ARGUMENTS_INSTRUMENTATION
+  inline constexpr bool enabled = true;
+  #else
+  inline constexpr bool enabled = false;
+  #endif
+
+  // Makes linking instrumented and uninstrumented translation units together an error. MSVC compares the pragma's
+  // value across objects. For ELF the marker is one weak symbol defined thread-local in one mode and not in the
+  // other, which GNU ld and gold reject ("TLS definition mismatches non-TLS definition").
+  #if defined(_MSC_VER)
+  #ifdef ARGUMENTS_INSTRUMENTATION
+  #pragma detect_mismatch("arguments_instrumentation", "on")
+  #else
+  #pragma detect_mismatch("arguments_instrumentation", "off")
+  #endif
+  #elif defined(__ELF__)
+  #ifdef ARGUMENTS_INSTRUMENTATION
+  [[gnu::weak, gnu::used]] thread_local int mode_marker asm("__arguments_instrumentation_mode") = 0;
+  #else
+  [[gnu::weak, gnu::used]] int mode_marker asm("__arguments_instrumentation_mode") = 0;
+  #endif
+  #endif
+
+  enum counter : size_t {
+    constructions,
+    conversions_char,
+    conversions_wchar,
+    conversions_char8,
+    conversions_char16,
+    conversions_char32,
+    bytes_transcoded, // native bytes of arguments that went through a successful codecvt conversion
+    allocations, // heap allocations of the strings built by argument::string<EcharT>(), including intermediates
+    conversion_failures,
+    parse_nanoseconds
+  };
+
+  // Not an enumerator, so that arguments_statistics's using enum does not make it a valid index
+  inline constexpr size_t counter_count = parse_nanoseconds + 1;
+
+  inline constexpr const char* counter_names[counter_count] = {
+    "constructions",
+    "conversions_char",
+    "conversions_wchar",
+    "conversions_char8",
+    "conversions_char16",
+    "conversions_char32",
+    "bytes_transcoded",
+    "allocations",
+    "conversion_failures",
+    "parse_nanoseconds"
+  };
+
+  template<typename _EcharT>
+  constexpr counter conversion_counter() {
+    if constexpr(is_same_v<_EcharT, char>) {
+      return conversions_char;
+    } else if constexpr(is_same_v<_EcharT, wchar_t>) {
+      return conversions_wchar;
+    } else if constexpr(is_same_v<_EcharT, char8_t>) {
+      return conversions_char8;
+    } else if constexpr(is_same_v<_EcharT, char16_t>) {
+      return conversions_char16;
+    } else {
+      return conversions_char32;
+    }
+  }
+
+  #ifdef ARGUMENTS_INSTRUMENTATION
+  struct thread_counters {
+    atomic<uint64_t> values[counter_count] {};
+  };
+
+  struct registry {
+    mutex lock;
+    vector<thread_counters*> threads;
+    uint64_t retired[counter_count] {};
+  };
+
+  inline registry& get_registry() {
+    static registry instance;
+    return instance;
+  }
+
+  // Registers the calling thread's counters on first use and folds them into the retired totals on thread exit
+  struct thread_slot {
+    thread_counters counters;
+    thread_slot() {
+      auto& reg = get_registry();
+      lock_guard guard(reg.lock);
+      reg.threads.push_back(&counters);
+    }
+    ~thread_slot() {
+      auto& reg = get_registry();
+      lock_guard guard(reg.lock);
+      for(size_t i = 0; i < counter_count; i++) {
+        reg.retired[i] += counters.values[i].load(memory_order_relaxed);
+      }
+      reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), &counters));
+    }
+    thread_slot(const thread_slot&) = delete;
+    thread_slot& operator=(const thread_slot&) = delete;
+  };
+
+  inline thread_counters& local_counters() {
+    thread_local thread_slot slot;
+    return slot.counters;
+  }
+
+  // Not noexcept: the first call on a thread registers it, which allocates
+  inline void add(counter c, uint64_t n = 1) {
+    // single writer, a plain load + store avoids a locked read-modify-write
+    auto& value = local_counters().values[c];
+    value.store(value.load(memory_order_relaxed) + n, memory_order_relaxed);
+  }
+
+  inline void collect(uint64_t (&out)[counter_count]) {
+    auto& reg = get_registry();
+    lock_guard guard(reg.lock);
+    for(size_t i = 0; i < counter_count; i++) {
+      out[i] = reg.retired[i];
+    }
+    for(const auto* counters : reg.threads) {
+      for(size_t i = 0; i < counter_count; i++) {
+        out[i] += counters->values[i].load(memory_order_relaxed);
+      }
+    }
+  }
+
+  class scoped_timer {
+  public:
+    explicit scoped_timer(counter c) : c(c) {
+      local_counters(); // register the thread here rather than in the destructor, which must not throw
+      start = chrono::steady_clock::now();
+    }
+    ~scoped_timer() {
+      auto elapsed = chrono::steady_clock::now() - start;
+      add(c, static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()));
+    }
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+  private:
+    counter c;
+    chrono::steady_clock::time_point start;
+  };
+  #else
+  inline void add(counter, uint64_t = 1) {}
+
+  inline void collect(uint64_t (&out)[counter_count]) {
+    for(auto& value : out) {
+      value = 0;
+    }
+  }
+
+  class scoped_timer {
+  public:
+    explicit scoped_timer(counter) {}
+  };
+  #endif
+
+  template<typename _EcharT>
+  inline void count_conversion() {
+    if constexpr(enabled) {
+      add(conversion_counter<_EcharT>());
+    }
+  }
+
+  // Strings in the conversion path grow at most once, so a capacity change is exactly one allocation
+  inline void count_allocation([[maybe_unused]] size_t old_capacity, [[maybe_unused]] size_t new_capacity) {
+    if constexpr(enabled) {
+      if(new_capacity != old_capacity) {
+        add(allocations);
+      }
+    }
+  }
+}
+
+namespace std {
+  // Aggregated instrumentation counters, see detail/instrumentation.hpp. All zero unless ARGUMENTS_INSTRUMENTATION
+  // is defined. Counters are cumulative; subtract two snapshots to measure an interval.
+  struct arguments_statistics {
+    static constexpr bool enabled = arg_detail::instrumentation::enabled;
+
+    using enum arg_detail::instrumentation::counter;
+
+    uint64_t values[arg_detail::instrumentation::counter_count] {};
+
+    uint64_t operator[](arg_detail::instrumentation::counter c) const {
+      return values[c];
+    }
+
+    static arguments_statistics snapshot() {
+      arguments_statistics stats;
+      arg_detail::instrumentation::collect(stats.values);
+      return stats;
+    }
+
+    // Calls f(name, value) for every counter, for exporting to a metrics system
+    template<class F>
+      void for_each(F&& f) const {
+        for(size_t i = 0; i < arg_detail::instrumentation::counter_count; i++) {
+          f(arg_detail::instrumentation::counter_names[i], values[i]);
+        }
+      }
+
+    friend arguments_statistics operator-(arguments_statistics lhs, const arguments_statistics& rhs) {
+      for(size_t i = 0; i < arg_detail::instrumentation::counter_count; i++) {
+        lhs.values[i] -= rhs.values[i];
+      }
+      return lhs;
+    }
+
+    // One "arguments.<name> <value>" line per counter
+    template<class charT, class traits>
+      friend basic_ostream<charT, traits>&
+        operator<<(basic_ostream<charT, traits>& os, const arguments_statistics& stats) {
+          stats.for_each([&os](const char* name, uint64_t value) {
+            os << "arguments." << name << ' ' << value << '\n';
+          });
+          return os;
+        }
+  };
+}
+
+#endif
@@ -10,7 +10,7 @@ namespace std::arg_detail {
   #ifdef _WIN32
   // https://github.com/huangqinjin/ucrt/blob/d6e817a4cc90f6f1fe54f8a0aa4af4fff0bb647d/startup/argv_parsing.cpp#L95
   // https://stdrs.dev/nightly/x86_64-pc-windows-gnu/src/std/sys/windows/args.rs.html#68
-  std::vector<std::wstring> parse_command_line(const wchar_t* command_line) {
+  inline std::vector<std::wstring> parse_command_line(const wchar_t* command_line) {
     std::vector<std::wstring> args;
 
     const wchar_t* cursor = command_line;
@@ -0,0 +1,211 @@
+#ifndef MULTICALL_HPP
+#define MULTICALL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+
+#include <arguments.hpp>
+
+// Dispatch for BusyBox-style multi-call binaries: the basename of argv[0], or failing that argv[1], selects a handler
+// from a table fixed at compile time.
+//
+//   int ls_main(std::ranges::subrange<std::arguments_iterator> args);
+//   int cat_main(std::ranges::subrange<std::arguments_iterator> args);
+//
+//   constexpr std::multicall_dispatcher dispatch({
+//     {"ls", ls_main},
+//     {"cat", cat_main},
+//   });
+//
+//   int main() {
+//     return dispatch(std::arguments{}).value_or(127);
+//   }
+//
+// The table is a perfect hash built by the consteval constructor (hash and displace: every key hashes to a bucket and
+// each bucket gets a displacement which moves its keys into free slots). A lookup hashes the name once, reads one
+// displacement and does a single string comparison, independent of the number of commands. Duplicate or empty names
+// are a compile error.
+
+namespace std {
+  struct multicall_command {
+    using handler_type = int(*)(ranges::subrange<arguments_iterator>);
+    argument::string_view_type name;
+    handler_type handler = nullptr;
+  };
+
+  template<size_t N>
+  class multicall_dispatcher {
+    static_assert(N > 0, "multicall_dispatcher needs at least one command");
+  public:
+    using string_view_type = argument::string_view_type;
+    using subrange_type = ranges::subrange<arguments_iterator>;
+
+    consteval multicall_dispatcher(const multicall_command (&commands)[N]) {
+      array<uint64_t, N> hashes;
+      array<size_t, N> buckets;
+      array<size_t, table_size> bucket_sizes{};
+      for(size_t i = 0; i < N; i++) {
+        if(commands[i].name.empty() || !commands[i].handler) {
+          throw invalid_argument("multicall_dispatcher: command with an empty name or no handler");
+        }
+        hashes[i] = hash(commands[i].name);
+        buckets[i] = bucket(hashes[i]);
+        bucket_sizes[buckets[i]]++;
+      }
+
+      // group the commands by bucket, then place the largest buckets first while the table is still mostly empty.
+      // Both are counting sorts, a comparison sort costs far more constant evaluation steps with many commands.
+      array<size_t, table_size + 1> bucket_start{};
+      array<size_t, N + 1> size_start{};
+      for(size_t b = 0; b < table_size; b++) {
+        bucket_start[b + 1] = bucket_start[b] + bucket_sizes[b];
+        size_start[bucket_sizes[b]]++;
+      }
+      array<size_t, N> by_bucket;
+      array<size_t, table_size> fill{};
+      for(size_t i = 0; i < N; i++) {
+        by_bucket[bucket_start[buckets[i]] + fill[buckets[i]]++] = i;
+      }
+      size_t placed = 0;
+      for(size_t size = N; size > 0; size--) {
+        size_t count = size_start[size];
+        size_start[size] = placed;
+        placed += count;
+      }
+      array<size_t, table_size> order;
+      for(size_t b = 0; b < table_size; b++) {
+        if(bucket_sizes[b]) {
+          order[size_start[bucket_sizes[b]]++] = b;
+        }
+      }
+
+      array<bool, table_size> used{};
+      array<size_t, N> candidate{};
+      for(size_t k = 0; k < placed; k++) {
+        size_t b = order[k];
+        size_t first = bucket_start[b];
+        size_t last = bucket_start[b + 1];
+        // equal names hash equally, so duplicates can only be within a bucket
+        for(size_t i = first; i < last; i++) {
+          for(size_t j = first; j < i; j++) {
+            if(commands[by_bucket[i]].name == commands[by_bucket[j]].name) {
+              throw invalid_argument("multicall_dispatcher: duplicate command name");
+            }
+          }
+        }
+        uint32_t displacement = 0;
+        for(;; displacement++) {
+          if(displacement == max_displacement) {
+            throw logic_error("multicall_dispatcher: failed to build a perfect hash");
+          }
+          bool fits = true;
+          for(size_t i = first; i < last && fits; i++) {
+            candidate[i] = slot(hashes[by_bucket[i]], displacement);
+            fits = !used[candidate[i]];
+            for(size_t j = first; j < i && fits; j++) {
+              fits = candidate[i] != candidate[j];
+            }
+          }
+          if(fits) {
+            break;
+          }
+        }
+        displacements[b] = displacement;
+        for(size_t i = first; i < last; i++) {
+          used[candidate[i]] = true;
+          slots[candidate[i]] = commands[by_bucket[i]];
+        }
+      }
+    }
+
+    // The command with the given name, or nullptr
+    constexpr const multicall_command* find(string_view_type name) const noexcept {
+      uint64_t h = hash(name);
+      const multicall_command& command = slots[slot(h, displacements[bucket(h)])];
+      return command.handler && command.name == name ? &command : nullptr;
+    }
+
+    // Runs the command named by the basename of args[0] with the arguments after it, otherwise the command named by
+    // args[1] with the arguments after that. nullopt if neither names a command.
+    template<class Allocator>
+      optional<int> operator()(const arguments<Allocator>& args) const {
+        if(args.empty()) {
+          return nullopt;
+        }
+        if(auto command = find(basename(args[0].native()))) {
+          return command->handler(subrange_type{args.begin() + 1, args.end()});
+        }
+        if(args.size() > 1) {
+          if(auto command = find(args[1].native())) {
+            return command->handler(subrange_type{args.begin() + 2, args.end()});
+          }
+        }
+        return nullopt;
+      }
+
+    // The final path component, a view into path
+    static constexpr string_view_type basename(string_view_type path) noexcept {
+      #ifndef _WIN32
+      auto separator = path.find_last_of('/');
+      #else
+      auto separator = path.find_last_of(L"/\\");
+      #endif
+      if(separator != string_view_type::npos) {
+        path.remove_prefix(separator + 1);
+      }
+      #ifdef _WIN32
+      constexpr string_view_type extension = L".exe";
+      if(path.size() > extension.size()) {
+        auto suffix = path.substr(path.size() - extension.size());
+        if(ranges::equal(suffix, extension, {}, [](wchar_t c) { return c >= L'A' && c <= L'Z' ? c - L'A' + L'a' : c; })) {
+          path.remove_suffix(extension.size());
+        }
+      }
+      #endif
+      return path;
+    }
+
+  private:
+    // at most half full so displacement searches stay short, with thousands of commands the constructor has to stay
+    // within the compilers' constant evaluation limits
+    static constexpr size_t table_size = bit_ceil(2 * N);
+    static constexpr uint32_t max_displacement = 1 << 16;
+
+    // FNV-1a over the code units
+    static constexpr uint64_t hash(string_view_type name) noexcept {
+      uint64_t h = 14695981039346656037ull;
+      for(auto c : name) {
+        h ^= static_cast<uint64_t>(c);
+        h *= 1099511628211ull;
+      }
+      return h;
+    }
+    // murmur3 finalizer
+    static constexpr uint64_t mix(uint64_t h) noexcept {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ull;
+      h ^= h >> 33;
+      return h;
+    }
+    static constexpr size_t bucket(uint64_t h) noexcept {
+      return mix(h) & (table_size - 1);
+    }
+    static constexpr size_t slot(uint64_t h, uint32_t displacement) noexcept {
+      return mix(h ^ ((displacement + 1) * 0x9e3779b97f4a7c15ull)) & (table_size - 1);
+    }
+
+    array<uint32_t, table_size> displacements{};
+    array<multicall_command, table_size> slots{};
+  };
+}
+
+#endif
@@ -1,9 +1,37 @@
 #include <arguments.hpp>
+#include <multicall.hpp>
 
 #include <algorithm>
 #include <iostream>
 #include <print>
 #include <ranges>
+#include <span>
+
+#ifdef _WIN32
+#define ARG(str) L##str
+#else
+#define ARG(str) str
+#endif
+
+// Prints what it was given, to show where the dispatched subrange starts and ends
+int echo_main(std::ranges::subrange<std::arguments_iterator> rest) {
+  std::println("echo command, {} remaining arguments", rest.size());
+  for(const auto& arg : rest) {
+    std::println("  {}", arg);
+  }
+  return 0;
+}
+
+int false_main(std::ranges::subrange<std::arguments_iterator>) {
+  return 1;
+}
+
+// Deliberately not named after this binary: `scratch echo a b` dispatches on args[1], a symlink named echo dispatches on
+// args[0] and anything else matches nothing
+constexpr std::multicall_dispatcher dispatch({
+  {ARG("echo"), echo_main},
+  {ARG("false"), false_main},
+});
 
 int main() {
   #ifdef _WIN32
@@ -55,12 +83,22 @@ int main() {
   out << it++->c_str() << std::endl;
   out << it->c_str() << std::endl;
 
+  std::println("---------------- contiguous range and argv()");
+  static_assert(std::ranges::contiguous_range<std::arguments<>> && std::ranges::sized_range<std::arguments<>>);
+  std::span<const std::argument> span{args};
+  out << span.back().native() << std::endl;
+  for(auto argv = args.argv(); *argv; argv++) {
+    out << *argv << std::endl;
+  }
+
+  std::println("---------------- multicall dispatch");
+  if(auto status = dispatch(args)) {
+    std::println("command returned {}", *status);
+  } else {
+    std::println("no command matched");
+  }
+
   std::println("---------------- encoding stuff");
-  #ifdef _WIN32
-  #define ARG(str) L##str
-  #else
-  #define ARG(str) str
-  #endif
   if(args.at(1).native() == ARG("--help")) {
     std::println("arguments[1] is --help, using ARG macro");
   }